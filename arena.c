@@ -0,0 +1,178 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "arena.h"
+
+#define ARENA_MIN_SHIFT 5          // smallest block is 32 bytes
+#define ARENA_CLASSES   12         // largest pooled block is 64 KiB
+#define ARENA_LARGE     ARENA_CLASSES
+#define ARENA_HEADER    16         // keeps blocks 16-byte aligned
+#define ARENA_CHUNK     (64 << 10) // default chunk size
+
+// every block is preceded by a header naming its size class
+// pooled blocks are carved from chunks and recycled through per-class free lists
+// blocks larger than the biggest class go straight to malloc
+typedef struct {
+    uint64_t cls;   // size class, or ARENA_LARGE
+    uint64_t size;  // usable bytes
+} ArenaHeader;
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    uint64_t pad;   // keeps carved blocks 16-byte aligned
+} ArenaChunk;
+
+typedef struct ArenaFree {
+    struct ArenaFree *next;
+} ArenaFree;
+
+// per-thread arena state, so allocation never takes a lock
+typedef struct {
+    ArenaFree *free[ARENA_CLASSES];
+    uint8_t *bump;          // next free byte in the current chunk
+    uint8_t *bump_end;      // end of the current chunk
+    ArenaChunk *chunks;     // all chunks owned by this thread
+    uint64_t chunk_size;    // bytes per chunk, set by arena_size
+    uint64_t in_use;        // bytes handed out and not yet freed
+    uint64_t peak;          // most bytes in use at once
+    uint64_t reserved;      // bytes held in chunks
+    uint64_t allocs;        // number of allocations
+    uint64_t refills;       // allocations that needed a new chunk
+    uint64_t large;         // allocations passed through to malloc
+} Arena;
+
+static _Thread_local Arena arena;
+
+// takes in block size size
+// returns the smallest size class holding size bytes, or ARENA_LARGE
+static uint64_t arena_class(size_t size) {
+    uint64_t cls = 0;
+    while (cls < ARENA_CLASSES && ((size_t) 1 << (cls + ARENA_MIN_SHIFT)) < size) {
+        cls += 1;
+    }
+    return cls;
+}
+
+// takes in size class cls
+// carves a block of class cls from the current chunk, starting a new chunk if needed
+// returns pointer to the block header
+static ArenaHeader *arena_carve(uint64_t cls) {
+    uint64_t need = ARENA_HEADER + ((uint64_t) 1 << (cls + ARENA_MIN_SHIFT));
+    if (arena.bump == NULL || (uint64_t) (arena.bump_end - arena.bump) < need) {
+        uint64_t size = arena.chunk_size > 0 ? arena.chunk_size : ARENA_CHUNK;
+        if (size < need) {
+            size = need;
+        }
+        ArenaChunk *chunk = (ArenaChunk *) malloc(sizeof(ArenaChunk) + size);
+        if (chunk == NULL) {
+            fprintf(stderr, "arena: out of memory\n");
+            abort();
+        }
+        chunk->next = arena.chunks;
+        arena.chunks = chunk;
+        arena.bump = (uint8_t *) (chunk + 1);
+        arena.bump_end = arena.bump + size;
+        arena.reserved += size;
+        arena.refills += 1;
+    }
+    ArenaHeader *h = (ArenaHeader *) arena.bump;
+    arena.bump += need;
+    return h;
+}
+
+// takes in number of bytes size
+// allocates a block of at least size bytes for GMP
+// returns pointer to the block
+static void *arena_alloc(size_t size) {
+    uint64_t cls = arena_class(size);
+    ArenaHeader *h = NULL;
+    if (cls == ARENA_LARGE) {
+        if ((h = (ArenaHeader *) malloc(ARENA_HEADER + size)) == NULL) {
+            fprintf(stderr, "arena: out of memory\n");
+            abort();
+        }
+        h->size = size;
+        arena.large += 1;
+    } else if (arena.free[cls] != NULL) {
+        h = (ArenaHeader *) ((uint8_t *) arena.free[cls] - ARENA_HEADER);
+        arena.free[cls] = arena.free[cls]->next;
+    } else {
+        h = arena_carve(cls);
+        h->size = (uint64_t) 1 << (cls + ARENA_MIN_SHIFT);
+    }
+    h->cls = cls;
+    arena.allocs += 1;
+    arena.in_use += h->size;
+    if (arena.in_use > arena.peak) {
+        arena.peak = arena.in_use;
+    }
+    return (uint8_t *) h + ARENA_HEADER;
+}
+
+// takes in block ptr, its size as known by GMP
+// returns block ptr to the free list of its size class
+static void arena_free(void *ptr, size_t size) {
+    (void) size;
+    ArenaHeader *h = (ArenaHeader *) ((uint8_t *) ptr - ARENA_HEADER);
+    arena.in_use -= h->size;
+    if (h->cls == ARENA_LARGE) {
+        free(h);
+        return;
+    }
+    ArenaFree *f = (ArenaFree *) ptr;
+    f->next = arena.free[h->cls];
+    arena.free[h->cls] = f;
+}
+
+// takes in block ptr, its old size, new size
+// grows or shrinks block ptr, keeping it in place if its class still fits
+// returns pointer to the resized block
+static void *arena_realloc(void *ptr, size_t old_size, size_t new_size) {
+    ArenaHeader *h = (ArenaHeader *) ((uint8_t *) ptr - ARENA_HEADER);
+    if (new_size <= h->size) {
+        return ptr;
+    }
+    void *block = arena_alloc(new_size);
+    memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+    arena_free(ptr, old_size);
+    return block;
+}
+
+// registers the arena as GMP's allocator
+// must be called before any GMP value is allocated
+void arena_init(void) {
+    mp_set_memory_functions(arena_alloc, arena_realloc, arena_free);
+}
+
+// takes in number of limbs of the key modulus limbs
+// sizes this thread's chunks to hold a working set of products of that size
+void arena_size(uint64_t limbs) {
+    uint64_t size = ARENA_CHUNK;
+    while (size < limbs * sizeof(mp_limb_t) * 64) {
+        size *= 2;
+    }
+    arena.chunk_size = size;
+}
+
+// takes in output file f
+// prints this thread's allocation statistics to f
+void arena_stats(FILE *f) {
+    fprintf(f, "arena: peak %" PRIu64 " bytes, %" PRIu64 " reserved in %" PRIu64 " chunks\n",
+        arena.peak, arena.reserved, arena.refills);
+    fprintf(f, "arena: %" PRIu64 " allocations, %" PRIu64 " passed to malloc\n", arena.allocs,
+        arena.large);
+}
+
+// frees all chunks owned by this thread
+// must be called after every GMP value allocated by this thread is cleared
+void arena_clear(void) {
+    while (arena.chunks != NULL) {
+        ArenaChunk *next = arena.chunks->next;
+        free(arena.chunks);
+        arena.chunks = next;
+    }
+    memset(&arena, 0, sizeof(arena));
+}
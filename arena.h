@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <gmp.h>
+
+void arena_init(void);
+
+void arena_size(uint64_t limbs);
+
+void arena_stats(FILE *f);
+
+void arena_clear(void);
@@ -2,24 +2,32 @@
 #include <stdio.h>
 #include <getopt.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "rsa.h"
 #include "numtheory.h"
 #include "randstate.h"
+#include "keycache.h"
+#include "arena.h"
+#include "profile.h"
 
-#define OPTIONS "-hvi:o:n:"
+#define OPTIONS "-hvmbi:o:n:r:"
+#define BLIND_REFRESH 32
 
 // prints help statement
 void print_help(void) {
     printf("SYNOPSIS\n   Decrypts data using RSA decryption.\n");
     printf("   Encrypted data is encrypted by the encrypt program.\n\n");
-    printf("USAGE\n   ./decrypt [-hv] [-i infile] [-o outfile] -n pubkey -d privkey\n\n");
+    printf("USAGE\n   ./decrypt [-hvmb] [-r refresh] [-i infile] [-o outfile] -n pubkey -d privkey\n\n");
     printf("OPTIONS\n");
     printf("   -h              Display program help and usage.\n");
     printf("   -v              Display verbose program output.\n");
+    printf("   -m              Display allocator memory statistics.\n");
     printf("   -i infile       Input file of data to decrypt (default: stdin).\n");
     printf("   -o outfile      Output file for decrypted data (default: stdout).\n");
     printf("   -n pvfile       Private key file (default: rsa.priv).\n");
+    printf("   -b              Blind decryption against timing side channels.\n");
+    printf("   -r refresh      Blocks between fresh blinding pairs (default: 32).\n");
 }
 
 // takes in input, output, and private key files
@@ -32,16 +40,27 @@ void close_files(FILE *infile, FILE *outfile, FILE *pvfile) {
 
 // main function to parse command line options and decrypt file
 int main(int argc, char **argv) {
+    // route all GMP allocations through the per-thread arena
+    arena_init();
+    // load this host's tuning profile, if any
+    profile_load(profile_path());
     FILE *infile = stdin;
     FILE *outfile = stdout;
     FILE *pvfile = NULL;
+    char *pvpath = "rsa.priv";
     bool v_case = false;
+    bool m_case = false;
     bool n_case = false;
+    bool b_case = false;
+    uint64_t refresh = BLIND_REFRESH;  // blocks between fresh blinding pairs defaulted to 32
     int32_t opt = 0;
     while ((opt = getopt(argc, argv, OPTIONS)) != -1) {
         switch (opt) {
         case 'h': print_help(); return 1; break;
         case 'v': v_case = true; break;
+        case 'm': m_case = true; break;
+        case 'b': b_case = true; break;
+        case 'r': refresh = strtoul(optarg, NULL, 10); break;
         case 'i':
             if ((infile = fopen(optarg, "r")) == NULL) {
                 printf("Failed to open %s\n", optarg);
@@ -59,6 +78,7 @@ int main(int argc, char **argv) {
                 printf("Failed to open %s\n", optarg);
                 return 1;
             }
+            pvpath = optarg;
             n_case = true;
             break;
         default: print_help(); return 1; break;
@@ -73,20 +93,49 @@ int main(int argc, char **argv) {
         }
     }
 
-    // read private key from pvfile
+    // read private key from its binary cache, falling back to pvfile
     mpz_t n, d, user;
     mpz_inits(n, d, user, NULL);
-    rsa_read_priv(n, d, pvfile);
+    if (!keycache_read_priv(pvpath, n, d)) {
+        rsa_read_priv(n, d, pvfile);
+        keycache_write_priv(pvpath, n, d);
+    }
     if (v_case) { // if verbose print is selected
         gmp_printf("n (%lu bits) = %Zd\n", mpz_sizeinbase(n, 2), n);
         gmp_printf("d (%lu bits) = %Zd\n", mpz_sizeinbase(d, 2), d);
     }
 
-    // decrypt file
-    rsa_decrypt_file(infile, outfile, n, d);
+    // size arena chunks and pick the tuned pow_mod backend for the modulus
+    arena_size(mpz_size(n));
+    profile_apply(mpz_sizeinbase(n, 2));
+
+    // decrypt file, blinding each block if selected
+    if (b_case) {
+        // seed blinding from /dev/urandom, falling back to time(NULL)
+        uint64_t seed = time(NULL);
+        FILE *urandom = fopen("/dev/urandom", "r");
+        if (urandom != NULL) {
+            if (fread(&seed, sizeof(seed), 1, urandom) != 1) {
+                seed ^= (uint64_t) clock();
+            }
+            fclose(urandom);
+        }
+        randstate_init(seed);
+        RSABlind blind;
+        rsa_blind_init(&blind, refresh);
+        rsa_decrypt_file(infile, outfile, n, d, &blind);
+        rsa_blind_clear(&blind);
+        randstate_clear();
+    } else {
+        rsa_decrypt_file(infile, outfile, n, d, NULL);
+    }
     
     // cleanup time
     close_files(infile, outfile, pvfile);
-    mpz_clears(n, d, NULL);
+    mpz_clears(n, d, user, NULL);
+    if (m_case) { // if memory statistics are selected
+        arena_stats(stderr);
+    }
+    arena_clear();
     return 0;
 }
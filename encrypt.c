@@ -6,17 +6,21 @@
 #include "rsa.h"
 #include "numtheory.h"
 #include "randstate.h"
+#include "keycache.h"
+#include "arena.h"
+#include "profile.h"
 
-#define OPTIONS "-hvi:o:n:"
+#define OPTIONS "-hvmi:o:n:"
 
 // prints help statement
 void print_help(void) {
     printf("SYNOPSIS\n   Encrypts data using RSA encryption.\n");
     printf("   Encrypted data is decrypted by the decrypt program.\n\n");
-    printf("USAGE\n   ./encrypt [-hv] [-i infile] [-o outfile] -n pubkey -d privkey\n\n");
+    printf("USAGE\n   ./encrypt [-hvm] [-i infile] [-o outfile] -n pubkey -d privkey\n\n");
     printf("OPTIONS\n");
     printf("   -h              Display program help and usage.\n");
     printf("   -v              Display verbose program output.\n");
+    printf("   -m              Display allocator memory statistics.\n");
     printf("   -i infile       Input file of data to encrypt (default: stdin).\n");
     printf("   -o outfile      Output file for encrypted data (default: stdout).\n");
     printf("   -n pbfile       Public key file (default: rsa.pub).\n");
@@ -32,16 +36,23 @@ void close_files(FILE *infile, FILE *outfile, FILE *pbfile) {
 
 // main function to parse command line options and encrypt files
 int main(int argc, char **argv) {
+    // route all GMP allocations through the per-thread arena
+    arena_init();
+    // load this host's tuning profile, if any
+    profile_load(profile_path());
     FILE *infile = stdin;
     FILE *outfile = stdout;
     FILE *pbfile = NULL;
+    char *pbpath = "rsa.pub";
     bool v_case = false;
+    bool m_case = false;
     bool n_case = false;
     int32_t opt = 0;
     while ((opt = getopt(argc, argv, OPTIONS)) != -1) {
         switch (opt) {
         case 'h': print_help(); return 1; break;
         case 'v': v_case = true; break;
+        case 'm': m_case = true; break;
         case 'i':
             if ((infile = fopen(optarg, "r")) == NULL) {
                 printf("Failed to open %s\n", optarg);
@@ -59,6 +70,7 @@ int main(int argc, char **argv) {
                 printf("Failed to open pbfile\n");
                 return 1;
             }
+            pbpath = optarg;
             n_case = true;
             break;
         default: print_help(); return 1; break;
@@ -73,11 +85,14 @@ int main(int argc, char **argv) {
         }
     }
 
-    // read public key from infile
+    // read public key from its binary cache, falling back to pbfile
     mpz_t n, e, s, user;
     mpz_inits(n, e, s, user, NULL);
     char *username = getenv("USER");
-    rsa_read_pub(n, e, s, username, pbfile);
+    bool cached = keycache_read_pub(pbpath, n, e, s, username);
+    if (!cached) {
+        rsa_read_pub(n, e, s, username, pbfile);
+    }
 
     if (v_case) { // if verbose print is selected
         printf("user = %s\n", username);
@@ -86,14 +101,21 @@ int main(int argc, char **argv) {
         gmp_printf("e (%lu bits) = %Zd\n", mpz_sizeinbase(e, 2), e);
     }
 
+    // size arena chunks and pick the tuned pow_mod backend for the modulus
+    arena_size(mpz_size(n));
+    profile_apply(mpz_sizeinbase(n, 2));
+
     // convert username to mpz_t
     mpz_set_str(user, username, 62);
-    // verify signature
-    if (!rsa_verify(user, s, e, n)) {
-        printf("Error: cannot be verified\n");
-        mpz_clears(n, e, s, user, NULL);
-        close_files(infile, outfile, pbfile);
-        return 1;
+    // verify signature (cached keys were verified before being cached)
+    if (!cached) {
+        if (!rsa_verify(user, s, e, n)) {
+            printf("Error: cannot be verified\n");
+            mpz_clears(n, e, s, user, NULL);
+            close_files(infile, outfile, pbfile);
+            return 1;
+        }
+        keycache_write_pub(pbpath, n, e, s, username);
     }
     
     // encrypt file
@@ -102,5 +124,9 @@ int main(int argc, char **argv) {
     // cleanup time
     close_files(infile, outfile, pbfile);
     mpz_clears(n, e, s, user, NULL);
+    if (m_case) { // if memory statistics are selected
+        arena_stats(stderr);
+    }
+    arena_clear();
     return 0;
 }
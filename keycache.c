@@ -0,0 +1,253 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "keycache.h"
+
+#define KEYCACHE_MAGIC   "RSAKEYC"
+#define KEYCACHE_VERSION 1
+#define KEYCACHE_PUB     1
+#define KEYCACHE_PRIV    2
+#define KEYCACHE_SUFFIX  ".cache"
+#define KEYCACHE_PATH    4096
+
+// binary key cache layout: a header followed by length-prefixed fields
+// each field is a uint64_t byte length and its data padded to 8 bytes
+// integers are stored as their 64-bit limbs, least significant first
+typedef struct {
+    char magic[8];      // "RSAKEYC"
+    uint32_t version;   // KEYCACHE_VERSION
+    uint32_t kind;      // KEYCACHE_PUB or KEYCACHE_PRIV
+    uint64_t src_size;  // size of the hex key file the cache was made from
+    int64_t src_sec;    // mtime of the hex key file (seconds)
+    int64_t src_nsec;   // mtime of the hex key file (nanoseconds)
+    uint64_t body_size; // bytes of fields following the header
+    uint64_t checksum;  // FNV-1a hash of the fields
+} KeyCacheHeader;
+
+// takes in buffer buf of len bytes
+// computes 64-bit FNV-1a hash of buf
+// returns hash
+static uint64_t keycache_checksum(const uint8_t *buf, uint64_t len) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint64_t i = 0; i < len; i += 1) {
+        h ^= buf[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// takes in key file path keypath, output buffer path
+// writes path of the cache file belonging to keypath to path
+// returns false if the path does not fit
+static bool keycache_path(const char *keypath, char path[]) {
+    int len = snprintf(path, KEYCACHE_PATH, "%s%s", keypath, KEYCACHE_SUFFIX);
+    return len > 0 && len < KEYCACHE_PATH;
+}
+
+// takes in large integer x
+// returns bytes x takes as a cache field, including its length prefix
+static uint64_t keycache_mpz_size(mpz_t x) {
+    uint64_t words = mpz_sgn(x) == 0 ? 0 : (mpz_sizeinbase(x, 2) + 63) / 64;
+    return sizeof(uint64_t) + words * sizeof(uint64_t);
+}
+
+// takes in cursor p, large integer x
+// writes x as a field at p
+// returns cursor past the field
+static uint8_t *keycache_put_mpz(uint8_t *p, mpz_t x) {
+    size_t words = 0;
+    mpz_export(p + sizeof(uint64_t), &words, -1, sizeof(uint64_t), 0, 0, x);
+    uint64_t len = words * sizeof(uint64_t);
+    memcpy(p, &len, sizeof(len));
+    return p + sizeof(uint64_t) + len;
+}
+
+// takes in cursor p, string str
+// writes str as a field at p
+// returns cursor past the field
+static uint8_t *keycache_put_str(uint8_t *p, char str[]) {
+    uint64_t len = strlen(str);
+    memcpy(p, &len, sizeof(len));
+    memcpy(p + sizeof(uint64_t), str, len);
+    return p + sizeof(uint64_t) + ((len + 7) & ~(uint64_t) 7);
+}
+
+// takes in cursor p, end of body end
+// reads the field at p into data and len
+// returns cursor past the field, or NULL if the field overruns end
+static const uint8_t *keycache_get(const uint8_t *p, const uint8_t *end, const uint8_t **data, uint64_t *len) {
+    if (p == NULL || (uint64_t) (end - p) < sizeof(uint64_t)) {
+        return NULL;
+    }
+    memcpy(len, p, sizeof(*len));
+    uint64_t padded = (*len + 7) & ~(uint64_t) 7;
+    if (padded < *len || (uint64_t) (end - p) - sizeof(uint64_t) < padded) {
+        return NULL;
+    }
+    *data = p + sizeof(uint64_t);
+    return p + sizeof(uint64_t) + padded;
+}
+
+// takes in cursor p, end of body end, large integer x
+// reads the field at p into x
+// returns cursor past the field, or NULL if the field overruns end
+static const uint8_t *keycache_get_mpz(const uint8_t *p, const uint8_t *end, mpz_t x) {
+    const uint8_t *data = NULL;
+    uint64_t len = 0;
+    if ((p = keycache_get(p, end, &data, &len)) != NULL) {
+        mpz_import(x, len / sizeof(uint64_t), -1, sizeof(uint64_t), 0, 0, data);
+    }
+    return p;
+}
+
+// takes in key file path keypath, cache kind, fields body of body_size bytes
+// writes header and body to the cache file of keypath, replacing it atomically
+// failures are ignored since the hex key file remains the source of truth
+static void keycache_write(const char *keypath, uint32_t kind, uint8_t *body, uint64_t body_size) {
+    char path[KEYCACHE_PATH], tmp[KEYCACHE_PATH];
+    struct stat st;
+    if (!keycache_path(keypath, path) || stat(keypath, &st) != 0) {
+        return;
+    }
+    int len = snprintf(tmp, KEYCACHE_PATH, "%s.%ld", path, (long) getpid());
+    if (len <= 0 || len >= KEYCACHE_PATH) {
+        return;
+    }
+    KeyCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, KEYCACHE_MAGIC, sizeof(h.magic));
+    h.version = KEYCACHE_VERSION;
+    h.kind = kind;
+    h.src_size = st.st_size;
+    h.src_sec = st.st_mtim.tv_sec;
+    h.src_nsec = st.st_mtim.tv_nsec;
+    h.body_size = body_size;
+    h.checksum = keycache_checksum(body, body_size);
+    // private key caches get the same permissions keygen gives pvfile
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, kind == KEYCACHE_PRIV ? 0600 : 0644);
+    if (fd < 0) {
+        return;
+    }
+    bool ok = write(fd, &h, sizeof(h)) == (ssize_t) sizeof(h)
+              && write(fd, body, body_size) == (ssize_t) body_size;
+    close(fd);
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+    }
+}
+
+// takes in key file path keypath, cache kind, output map and map_size
+// maps the cache file of keypath if it matches keypath and passes its checksum
+// returns pointer to the fields, or NULL if the cache is missing or stale
+static const uint8_t *keycache_map(const char *keypath, uint32_t kind, void **map, size_t *map_size) {
+    char path[KEYCACHE_PATH];
+    struct stat src, st;
+    if (!keycache_path(keypath, path) || stat(keypath, &src) != 0) {
+        return NULL;
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) != 0 || (uint64_t) st.st_size < sizeof(KeyCacheHeader)) {
+        close(fd);
+        return NULL;
+    }
+    *map_size = st.st_size;
+    *map = mmap(NULL, *map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (*map == MAP_FAILED) {
+        return NULL;
+    }
+    KeyCacheHeader h;
+    memcpy(&h, *map, sizeof(h));
+    const uint8_t *body = (const uint8_t *) *map + sizeof(h);
+    // cache is stale if the hex key file changed since it was written
+    if (memcmp(h.magic, KEYCACHE_MAGIC, sizeof(h.magic)) != 0 || h.version != KEYCACHE_VERSION
+        || h.kind != kind || h.src_size != (uint64_t) src.st_size
+        || h.src_sec != src.st_mtim.tv_sec || h.src_nsec != src.st_mtim.tv_nsec
+        || h.body_size != *map_size - sizeof(h)
+        || h.checksum != keycache_checksum(body, h.body_size)) {
+        munmap(*map, *map_size);
+        return NULL;
+    }
+    return body;
+}
+
+// takes in public key file path keypath, large integers n, e, s, string username
+// reads public key (n, e), signature s, and username from the cache of keypath
+// the cache is only written for verified keys, so a hit needs no rsa_verify
+// returns false if there is no usable cache
+bool keycache_read_pub(const char *keypath, mpz_t n, mpz_t e, mpz_t s, char username[]) {
+    void *map = NULL;
+    size_t map_size = 0;
+    const uint8_t *p = keycache_map(keypath, KEYCACHE_PUB, &map, &map_size);
+    if (p == NULL) {
+        return false;
+    }
+    const uint8_t *end = (const uint8_t *) map + map_size;
+    const uint8_t *data = NULL;
+    uint64_t len = 0;
+    p = keycache_get_mpz(p, end, n);
+    p = keycache_get_mpz(p, end, e);
+    p = keycache_get_mpz(p, end, s);
+    p = keycache_get(p, end, &data, &len);
+    if (p != NULL) {
+        memcpy(username, data, len);
+        username[len] = '\0';
+    }
+    munmap(map, map_size);
+    return p != NULL;
+}
+
+// takes in public key file path keypath, large integers n, e, s, string username
+// writes public key (n, e), signature s, and username to the cache of keypath
+void keycache_write_pub(const char *keypath, mpz_t n, mpz_t e, mpz_t s, char username[]) {
+    uint64_t size = keycache_mpz_size(n) + keycache_mpz_size(e) + keycache_mpz_size(s)
+                    + sizeof(uint64_t) + ((strlen(username) + 7) & ~(uint64_t) 7);
+    uint8_t *body = (uint8_t *) calloc(size, sizeof(uint8_t));
+    uint8_t *p = body;
+    p = keycache_put_mpz(p, n);
+    p = keycache_put_mpz(p, e);
+    p = keycache_put_mpz(p, s);
+    p = keycache_put_str(p, username);
+    keycache_write(keypath, KEYCACHE_PUB, body, p - body);
+    free(body);
+    body = NULL;
+}
+
+// takes in private key file path keypath, large integers n, d
+// reads private key (d), modulus n from the cache of keypath
+// returns false if there is no usable cache
+bool keycache_read_priv(const char *keypath, mpz_t n, mpz_t d) {
+    void *map = NULL;
+    size_t map_size = 0;
+    const uint8_t *p = keycache_map(keypath, KEYCACHE_PRIV, &map, &map_size);
+    if (p == NULL) {
+        return false;
+    }
+    const uint8_t *end = (const uint8_t *) map + map_size;
+    p = keycache_get_mpz(p, end, n);
+    p = keycache_get_mpz(p, end, d);
+    munmap(map, map_size);
+    return p != NULL;
+}
+
+// takes in private key file path keypath, large integers n, d
+// writes private key (d), modulus n to the cache of keypath
+void keycache_write_priv(const char *keypath, mpz_t n, mpz_t d) {
+    uint64_t size = keycache_mpz_size(n) + keycache_mpz_size(d);
+    uint8_t *body = (uint8_t *) calloc(size, sizeof(uint8_t));
+    uint8_t *p = body;
+    p = keycache_put_mpz(p, n);
+    p = keycache_put_mpz(p, d);
+    keycache_write(keypath, KEYCACHE_PRIV, body, p - body);
+    free(body);
+    body = NULL;
+}
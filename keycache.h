@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <gmp.h>
+
+bool keycache_read_pub(const char *keypath, mpz_t n, mpz_t e, mpz_t s, char username[]);
+
+void keycache_write_pub(const char *keypath, mpz_t n, mpz_t e, mpz_t s, char username[]);
+
+bool keycache_read_priv(const char *keypath, mpz_t n, mpz_t d);
+
+void keycache_write_priv(const char *keypath, mpz_t n, mpz_t d);
@@ -8,16 +8,20 @@
 #include "rsa.h"
 #include "numtheory.h"
 #include "randstate.h"
+#include "keycache.h"
+#include "arena.h"
+#include "profile.h"
 
-#define OPTIONS "hvb:i:n:d:s:"
+#define OPTIONS "hvmb:i:n:d:s:"
 
 // prints help statement
 void print_help(void) {
     printf("SYNOPSIS\n   Generates an RSA public/private ket pair.\n\n");
-    printf("USAGE\n   ./keygen [-hv] [-b bits] -n pbfile -d pvfile\n\n");
+    printf("USAGE\n   ./keygen [-hvm] [-b bits] -n pbfile -d pvfile\n\n");
     printf("OPTIONS\n");
     printf("   -h              Display program help and usage.\n");
     printf("   -v              Display verbose program output.\n");
+    printf("   -m              Display allocator memory statistics.\n");
     printf("   -b bits         Minimum bits needed for public key n.\n");
     printf("   -c confidence   Miller-Rabin iterations for testing primes (default: 50).\n");
     printf("   -n pbfile       Public key file (default: rsa.pub).\n");
@@ -27,9 +31,16 @@ void print_help(void) {
 
 // main function to parse command line options and create public and private keys
 int main(int argc, char **argv) {
+    // route all GMP allocations through the per-thread arena
+    arena_init();
+    // load this host's tuning profile, if any
+    profile_load(profile_path());
     FILE *pbfile = NULL;
     FILE *pvfile = NULL;
+    char *pbpath = "rsa.pub";
+    char *pvpath = "rsa.priv";
     bool v_case = false;
+    bool m_case = false;
     bool n_case = false;
     bool d_case = false;
     uint64_t pubkey_bits = 256; // min bits for public key n defaulted to 256
@@ -40,6 +51,7 @@ int main(int argc, char **argv) {
         switch (opt) {
         case 'h': print_help(); return 1; break;
         case 'v': v_case = true; break;
+        case 'm': m_case = true; break;
         case 'b': pubkey_bits = strtoul(optarg, NULL, 10); break;
         case 'c': MR_iters = strtoul(optarg, NULL, 10); break;
         case 'n':
@@ -47,6 +59,7 @@ int main(int argc, char **argv) {
                 printf("Failed to open %s\n", optarg);
                 return 1;
             }
+            pbpath = optarg;
             n_case = true;
             break;
         case 'd':
@@ -54,6 +67,7 @@ int main(int argc, char **argv) {
                 printf("Failed to open %s\n", optarg);
                 return 1;
             }
+            pvpath = optarg;
             d_case = true;
             break;
         case 's': seed = strtoul(optarg, NULL, 10); break;
@@ -80,6 +94,10 @@ int main(int argc, char **argv) {
     int pvfile_fd = fileno(pvfile);
     fchmod(pvfile_fd, 0600);
 
+    // size arena chunks and pick the tuned pow_mod backend for the requested modulus
+    arena_size(pubkey_bits / GMP_NUMB_BITS + 1);
+    profile_apply(pubkey_bits);
+
     // initialize the random state
     randstate_init(seed);
 
@@ -100,6 +118,12 @@ int main(int argc, char **argv) {
     rsa_write_pub(n, e, s, username, pbfile);
     rsa_write_priv(n, d, pvfile);
 
+    // write binary caches so encrypt and decrypt can skip parsing the keys
+    fflush(pbfile);
+    fflush(pvfile);
+    keycache_write_pub(pbpath, n, e, s, username);
+    keycache_write_priv(pvpath, n, d);
+
     if (v_case) { // if verbose print is selected
         printf("user = %s\n", username);
         gmp_printf("s (%lu bits) = %Zd\n", mpz_sizeinbase(s, 2), s);
@@ -115,5 +139,9 @@ int main(int argc, char **argv) {
     fclose(pvfile);
     randstate_clear();
     mpz_clears(p, q, n, e, d, user, s, NULL);
+    if (m_case) { // if memory statistics are selected
+        arena_stats(stderr);
+    }
+    arena_clear();
     return 0;
 }
@@ -57,10 +57,21 @@ void mod_inverse(mpz_t o, mpz_t a, mpz_t n) {
     mpz_clears(r, r1, t, t1, q, math, r1_temp, t1_temp, NULL);
 }
 
+// exponentiation backend used by pow_mod, set by pow_mod_config
+static uint32_t pow_method = POW_BINARY;
+static uint32_t pow_window = 4;
+
+// takes in exponentiation backend method, window size window
+// selects the backend pow_mod uses, window is only used by POW_WINDOW
+void pow_mod_config(uint32_t method, uint32_t window) {
+    pow_method = method < POW_METHODS ? method : POW_BINARY;
+    pow_window = window < 1 ? 1 : window > 8 ? 8 : window;
+}
+
 // takes in large integers a, d, n
-// computes base a to the exponent d power modulus n, storing value in o
+// computes a^d mod n by right-to-left square-and-multiply
 // return value through o
-void pow_mod(mpz_t o, mpz_t a, mpz_t d, mpz_t n) {
+static void pow_mod_binary(mpz_t o, mpz_t a, mpz_t d, mpz_t n) {
     mpz_t v, p, d_val;
     mpz_init_set_ui(v, 1);  // v = 1
     mpz_init_set(p, a);     // p = a
@@ -80,6 +91,70 @@ void pow_mod(mpz_t o, mpz_t a, mpz_t d, mpz_t n) {
     mpz_clears(v, p, d_val, NULL);
 }
 
+// takes in large integers a, d, n, window size w
+// computes a^d mod n by left-to-right sliding window over odd powers of a
+// return value through o
+static void pow_mod_window(mpz_t o, mpz_t a, mpz_t d, mpz_t n, uint32_t w) {
+    uint64_t count = (uint64_t) 1 << (w - 1);
+    mpz_t *table = (mpz_t *) calloc(count, sizeof(mpz_t));
+    mpz_t v, a2;
+    mpz_init_set_ui(v, 1);  // v = 1
+    mpz_init(a2);
+    // table[i] = a^(2i + 1) % n
+    mpz_init(table[0]);
+    mpz_mod(table[0], a, n);
+    mpz_mul(a2, table[0], table[0]);
+    mpz_mod(a2, a2, n);     // a2 = a^2 % n
+    for (uint64_t i = 1; i < count; i += 1) {
+        mpz_init(table[i]);
+        mpz_mul(table[i], table[i - 1], a2);
+        mpz_mod(table[i], table[i], n);
+    }
+    int64_t i = (int64_t) mpz_sizeinbase(d, 2) - 1;
+    while (i >= 0) {
+        if (mpz_tstbit(d, i) == 0) {
+            // v = v*v % n
+            mpz_mul(v, v, v);
+            mpz_mod(v, v, n);
+            i -= 1;
+            continue;
+        }
+        // longest window d[i..j] of at most w bits ending in a set bit
+        int64_t j = i - (int64_t) w + 1 > 0 ? i - (int64_t) w + 1 : 0;
+        while (mpz_tstbit(d, j) == 0) {
+            j += 1;
+        }
+        uint64_t bits = 0;
+        for (int64_t k = i; k >= j; k -= 1) {
+            mpz_mul(v, v, v);
+            mpz_mod(v, v, n);
+            bits = (bits << 1) | mpz_tstbit(d, k);
+        }
+        // v = v * a^bits % n
+        mpz_mul(v, v, table[bits >> 1]);
+        mpz_mod(v, v, n);
+        i = j - 1;
+    }
+    mpz_set(o, v);
+    for (uint64_t t = 0; t < count; t += 1) {
+        mpz_clear(table[t]);
+    }
+    free(table);
+    table = NULL;
+    mpz_clears(v, a2, NULL);
+}
+
+// takes in large integers a, d, n
+// computes base a to the exponent d power modulus n with the configured backend
+// return value through o
+void pow_mod(mpz_t o, mpz_t a, mpz_t d, mpz_t n) {
+    switch (pow_method) {
+    case POW_WINDOW: pow_mod_window(o, a, d, n, pow_window); break;
+    case POW_GMP: mpz_powm(o, a, d, n); break;
+    default: pow_mod_binary(o, a, d, n); break;
+    }
+}
+
 // takes in large integer n, number of iterations iters
 // conducts Miller-Rabin primality test to determine if n is prime after iters number of iterations
 // returns boolean if prime
@@ -9,6 +9,13 @@ void gcd(mpz_t g, mpz_t a, mpz_t b);
 
 void mod_inverse(mpz_t o, mpz_t a, mpz_t n);
 
+#define POW_BINARY 0    // square-and-multiply
+#define POW_WINDOW 1    // sliding window
+#define POW_GMP    2    // mpz_powm
+#define POW_METHODS 3
+
+void pow_mod_config(uint32_t method, uint32_t window);
+
 void pow_mod(mpz_t o, mpz_t a, mpz_t d, mpz_t n);
 
 bool is_prime(mpz_t n, uint64_t iters);
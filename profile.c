@@ -0,0 +1,89 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "profile.h"
+#include "numtheory.h"
+
+#define PROFILE_DEFAULT "rsa.tune"
+#define PROFILE_ENV     "RSA_TUNE_PROFILE"
+#define PROFILE_ENTRIES 16
+
+// tuning profile written by the tune program, one line per modulus size:
+//   <bits> <method> <window>
+// lines starting with '#' are comments
+typedef struct {
+    uint64_t bits;      // modulus size the entry was measured at
+    uint32_t method;    // fastest pow_mod backend
+    uint32_t window;    // window size for POW_WINDOW
+} ProfileEntry;
+
+static ProfileEntry entries[PROFILE_ENTRIES];
+static uint32_t entry_count = 0;
+
+static const char *method_names[POW_METHODS] = { "binary", "window", "gmp" };
+
+// takes in pow_mod backend method
+// returns name of method as written in profiles
+const char *profile_method_name(uint32_t method) {
+    return method < POW_METHODS ? method_names[method] : "unknown";
+}
+
+// returns path of the tuning profile, $RSA_TUNE_PROFILE if set (default: rsa.tune)
+const char *profile_path(void) {
+    char *path = getenv(PROFILE_ENV);
+    return path != NULL ? path : PROFILE_DEFAULT;
+}
+
+// takes in profile path path
+// reads the tuning profile at path, replacing any loaded entries
+// returns false if path cannot be opened or has no valid entries
+bool profile_load(const char *path) {
+    FILE *f = fopen(path, "r");
+    entry_count = 0;
+    if (f == NULL) {
+        return false;
+    }
+    char line[128], name[16];
+    while (entry_count < PROFILE_ENTRIES && fgets(line, sizeof(line), f) != NULL) {
+        ProfileEntry *p = &entries[entry_count];
+        if (line[0] == '#'
+            || sscanf(line, "%" SCNu64 " %15s %" SCNu32, &p->bits, name, &p->window) != 3) {
+            continue;
+        }
+        for (p->method = 0; p->method < POW_METHODS; p->method += 1) {
+            if (strcmp(name, method_names[p->method]) == 0) {
+                entry_count += 1;
+                break;
+            }
+        }
+    }
+    fclose(f);
+    return entry_count > 0;
+}
+
+// takes in modulus size bits
+// configures pow_mod with the loaded entry closest to bits
+// leaves pow_mod unchanged if no profile is loaded
+void profile_apply(uint64_t bits) {
+    ProfileEntry *best = NULL;
+    uint64_t best_dist = UINT64_MAX;
+    for (uint32_t i = 0; i < entry_count; i += 1) {
+        uint64_t dist = entries[i].bits > bits ? entries[i].bits - bits : bits - entries[i].bits;
+        if (dist < best_dist) {
+            best = &entries[i];
+            best_dist = dist;
+        }
+    }
+    if (best != NULL) {
+        pow_mod_config(best->method, best->window);
+    }
+}
+
+// takes in output file f, modulus size bits, pow_mod backend method, window size window
+// writes a profile entry to f
+void profile_write(FILE *f, uint64_t bits, uint32_t method, uint32_t window) {
+    fprintf(f, "%" PRIu64 " %s %" PRIu32 "\n", bits, profile_method_name(method), window);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <gmp.h>
+
+const char *profile_path(void);
+
+bool profile_load(const char *path);
+
+void profile_apply(uint64_t bits);
+
+void profile_write(FILE *f, uint64_t bits, uint32_t method, uint32_t window);
+
+const char *profile_method_name(uint32_t method);
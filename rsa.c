@@ -131,9 +131,60 @@ void rsa_decrypt(mpz_t m, mpz_t c, mpz_t d, mpz_t n) {
     pow_mod(m, c, d, n);
 }
 
-// takes in input, output files, private key (d), modulus n
+// takes in blinding context b, number of blocks refresh
+// initializes b so a fresh blinding pair is made every refresh blocks
+void rsa_blind_init(RSABlind *b, uint64_t refresh) {
+    mpz_inits(b->vi, b->vf, NULL);
+    b->uses = 0;
+    b->refresh = refresh > 0 ? refresh : 1;
+}
+
+// clears and frees all memory used by blinding context b
+void rsa_blind_clear(RSABlind *b) {
+    mpz_clears(b->vi, b->vf, NULL);
+}
+
+// takes in blinding context b, private key (d), modulus n
+// picks random x coprime to n and sets vi = x, vf = (x^d)^-1 mod n
+// since x plays the role of r^e, this needs no public exponent
+static void rsa_blind_fresh(RSABlind *b, mpz_t d, mpz_t n) {
+    mpz_t t;
+    mpz_init(t);
+    do {
+        mpz_urandomm(b->vi, state, n);
+        pow_mod(t, b->vi, d, n);    // t = x^d mod n
+        mod_inverse(b->vf, t, n);   // vf = t^-1 mod n (0 if not invertible)
+    } while (mpz_cmp_ui(b->vi, 1) <= 0 || mpz_sgn(b->vf) == 0);
+    mpz_clear(t);
+}
+
+// takes in ciphertext c, private key (d), modulus n, blinding context b
+// performs blinded RSA decryption so pow_mod never sees c directly
+// the pair is squared between blocks and made fresh every b->refresh blocks
+// return value through m
+void rsa_decrypt_blind(mpz_t m, mpz_t c, mpz_t d, mpz_t n, RSABlind *b) {
+    if (b->uses % b->refresh == 0) {
+        rsa_blind_fresh(b, d, n);
+    } else {
+        // (x^2)^d = (x^d)^2, so squaring both keeps the pair valid
+        mpz_mul(b->vi, b->vi, b->vi);
+        mpz_mod(b->vi, b->vi, n);
+        mpz_mul(b->vf, b->vf, b->vf);
+        mpz_mod(b->vf, b->vf, n);
+    }
+    b->uses += 1;
+    // m = ((c * vi) % n)^d * vf % n
+    mpz_mul(m, c, b->vi);
+    mpz_mod(m, m, n);
+    pow_mod(m, m, d, n);
+    mpz_mul(m, m, b->vf);
+    mpz_mod(m, m, n);
+}
+
+// takes in input, output files, private key (d), modulus n, blinding context b
 // performs RSA decryption using private key (d) to decrypt infile to outfile
-void rsa_decrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t d) {
+// blinds each block with b unless b is NULL
+void rsa_decrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t d, RSABlind *b) {
     mpz_t k, math, cipher, message;
     mpz_inits(k, math, cipher, message, NULL);
     uint64_t total = 0;
@@ -157,7 +208,11 @@ void rsa_decrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t d) {
         // read from infile
         gmp_fscanf(infile, "%Zx\n", cipher);
         // decrypt cipher
-        rsa_decrypt(message, cipher, d, n);
+        if (b != NULL) {
+            rsa_decrypt_blind(message, cipher, d, n, b);
+        } else {
+            rsa_decrypt(message, cipher, d, n);
+        }
         // convert mpz_t to bytes
         mpz_export(arr, &j, 1, 1, 1, 0, message);
         // write to outfile
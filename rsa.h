@@ -21,9 +21,22 @@ void rsa_encrypt(mpz_t c, mpz_t m, mpz_t e, mpz_t n);
 
 void rsa_encrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t e);
 
+typedef struct {
+    mpz_t vi;           // blinding value applied to ciphertext
+    mpz_t vf;           // unblinding value applied to message
+    uint64_t uses;      // blocks decrypted with this context
+    uint64_t refresh;   // blocks between fresh blinding pairs
+} RSABlind;
+
+void rsa_blind_init(RSABlind *b, uint64_t refresh);
+
+void rsa_blind_clear(RSABlind *b);
+
 void rsa_decrypt(mpz_t m, mpz_t c, mpz_t d, mpz_t n);
 
-void rsa_decrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t d);
+void rsa_decrypt_blind(mpz_t m, mpz_t c, mpz_t d, mpz_t n, RSABlind *b);
+
+void rsa_decrypt_file(FILE *infile, FILE *outfile, mpz_t n, mpz_t d, RSABlind *b);
 
 void rsa_sign(mpz_t s, mpz_t m, mpz_t d, mpz_t n);
 
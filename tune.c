@@ -0,0 +1,131 @@
+
+#include <stdio.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "numtheory.h"
+#include "randstate.h"
+#include "profile.h"
+#include "arena.h"
+
+#define OPTIONS "hvo:r:s:"
+#define WINDOW_MIN 2
+#define WINDOW_MAX 6
+
+// modulus sizes to benchmark
+static const uint64_t tune_bits[] = { 2048, 3072, 4096 };
+
+// prints help statement
+void print_help(void) {
+    printf("SYNOPSIS\n   Benchmarks modular exponentiation backends on this machine.\n");
+    printf("   The fastest backend per modulus size is written to a profile\n");
+    printf("   that keygen, encrypt, and decrypt load at startup.\n\n");
+    printf("USAGE\n   ./tune [-hv] [-r reps] [-s seed] [-o profile]\n\n");
+    printf("OPTIONS\n");
+    printf("   -h              Display program help and usage.\n");
+    printf("   -v              Display every measurement.\n");
+    printf("   -r reps         Timed runs per backend, fastest is kept (default: 3).\n");
+    printf("   -s seed         Random seed for test operands.\n");
+    printf("   -o profile      Profile file (default: $RSA_TUNE_PROFILE or rsa.tune).\n");
+}
+
+// takes in large integers a, d, n, number of runs reps
+// times pow_mod with the current backend
+// returns fastest run in seconds
+double tune_time(mpz_t a, mpz_t d, mpz_t n, uint64_t reps) {
+    mpz_t o;
+    mpz_init(o);
+    double best = 0;
+    for (uint64_t i = 0; i < reps; i += 1) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pow_mod(o, a, d, n);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double t = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        if (i == 0 || t < best) {
+            best = t;
+        }
+    }
+    mpz_clear(o);
+    return best;
+}
+
+// main function to parse command line options and write a tuning profile
+int main(int argc, char **argv) {
+    // route all GMP allocations through the per-thread arena
+    arena_init();
+
+    const char *path = profile_path();
+    bool v_case = false;
+    uint64_t reps = 3;          // timed runs defaulted to 3
+    uint64_t seed = time(NULL); // seed defaulted to time(NULL)
+    int32_t opt = 0;
+    while ((opt = getopt(argc, argv, OPTIONS)) != -1) {
+        switch (opt) {
+        case 'h': print_help(); return 1; break;
+        case 'v': v_case = true; break;
+        case 'o': path = optarg; break;
+        case 'r': reps = strtoul(optarg, NULL, 10); break;
+        case 's': seed = strtoul(optarg, NULL, 10); break;
+        default: print_help(); return 1; break;
+        }
+    }
+    if (reps == 0) {
+        reps = 1;
+    }
+
+    FILE *pffile = NULL;
+    if ((pffile = fopen(path, "w")) == NULL) {
+        printf("Failed to open %s\n", path);
+        return 1;
+    }
+    fprintf(pffile, "# bits method window\n");
+
+    // initialize the random state
+    randstate_init(seed);
+
+    mpz_t a, d, n;
+    mpz_inits(a, d, n, NULL);
+    for (size_t b = 0; b < sizeof(tune_bits) / sizeof(tune_bits[0]); b += 1) {
+        uint64_t bits = tune_bits[b];
+        arena_size(bits / GMP_NUMB_BITS + 1);
+        // odd modulus of exactly bits bits, private-exponent-sized d, base below n
+        mpz_urandomb(n, state, bits);
+        mpz_setbit(n, bits - 1);
+        mpz_setbit(n, 0);
+        mpz_urandomb(d, state, bits);
+        mpz_urandomm(a, state, n);
+
+        uint32_t best_method = POW_BINARY;
+        uint32_t best_window = 0;
+        double best = 0;
+        for (uint32_t method = 0; method < POW_METHODS; method += 1) {
+            uint32_t w_min = method == POW_WINDOW ? WINDOW_MIN : 0;
+            uint32_t w_max = method == POW_WINDOW ? WINDOW_MAX : 0;
+            for (uint32_t w = w_min; w <= w_max; w += 1) {
+                pow_mod_config(method, w);
+                double t = tune_time(a, d, n, reps);
+                if (v_case) { // if verbose print is selected
+                    printf("%lu bits: %-6s w = %u: %.3f ms\n", (unsigned long) bits,
+                        profile_method_name(method), w, t * 1e3);
+                }
+                if ((method == 0 && w == w_min) || t < best) {
+                    best_method = method;
+                    best_window = w;
+                    best = t;
+                }
+            }
+        }
+        printf("%lu bits: %s (w = %u), %.3f ms\n", (unsigned long) bits,
+            profile_method_name(best_method), best_window, best * 1e3);
+        profile_write(pffile, bits, best_method, best_window);
+    }
+
+    // cleanup time
+    fclose(pffile);
+    randstate_clear();
+    mpz_clears(a, d, n, NULL);
+    arena_clear();
+    return 0;
+}